@@ -1,9 +1,14 @@
+// Compilar con: g++ -std=c++17 -O2 -pthread "solucion_ v1.cpp"
 #include <iostream>
 #include <string>
 #include <algorithm>
 #include <vector>
-#include <queue>
-#include <memory>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <thread>
+#include <unordered_map>
 #include <iomanip>
 #include <sstream>
 #include <cstdlib>
@@ -16,10 +21,10 @@ struct Miembro {
     string nombre;
     string fechaNacimiento;
     string genero;
-    int nivel;
+    int nivel;  // generacin: la calcula el rbol a partir de 'padre'
     
-    Miembro(int i, string n, string f, string g, int lvl = 0) 
-        : id(i), nombre(n), fechaNacimiento(f), genero(g), nivel(lvl) {}
+    Miembro(int i, string n, string f, string g) 
+        : id(i), nombre(n), fechaNacimiento(f), genero(g), nivel(0) {}
     
     void mostrar() const {
         cout << "ID: " << setw(3) << id << " | " 
@@ -30,47 +35,241 @@ struct Miembro {
     }
 };
 
+// ndice de un nodo dentro del vector de nodos del rbol
+using Indice = uint32_t;
+const Indice NULO = 0xFFFFFFFFu;
+
 struct Nodo {
     Miembro dato;
-    shared_ptr<Nodo> izquierdo;
-    shared_ptr<Nodo> derecho;
-    shared_ptr<Nodo> padre;
-    vector<shared_ptr<Nodo>> hijos;
+    Indice izquierdo;
+    Indice derecho;
+    Indice padre;
+    // Los hijos ocupan hijosPlano[primerHijo, primerHijo + numHijos) dentro
+    // de un bloque de capacidadHijos posiciones (adyacencia tipo CSR)
+    uint32_t primerHijo;
+    uint32_t numHijos;
+    uint32_t capacidadHijos;
     int altura;
     
-    Nodo(Miembro m) : dato(m), altura(1) {}
+    // ndice genealgico. [entrada, salida] es el intervalo del recorrido
+    // de Euler dentro de la familia: A es ancestro de B si son de la misma
+    // familia y el intervalo de A contiene al de B. La profundidad en la
+    // familia es dato.nivel; la tabla de saltos vive en el rbol
+    // (ArbolGenealogico::saltos) para no reservar memoria por nodo.
+    uint64_t entrada;
+    uint64_t salida;
+    Indice familia;
+    
+    Nodo(Miembro m) : dato(std::move(m)), izquierdo(NULO), derecho(NULO), padre(NULO),
+                      primerHijo(0), numHijos(0), capacidadHijos(0), altura(1),
+                      entrada(0), salida(UINT64_MAX), familia(NULO) {}
+};
+
+// Cola FIFO sobre un vector de capacidad potencia de dos; se reutiliza
+// entre recorridos y solo reserva cuando necesita ms capacidad
+template <class T>
+class ColaCircular {
+private:
+    vector<T> datos;
+    size_t mascara = 0;
+    size_t inicio = 0;
+    size_t cuenta = 0;
+    
+public:
+    void preparar(size_t capacidad) {
+        if (capacidad > datos.size()) {
+            size_t tam = 1;
+            while (tam < capacidad) tam <<= 1;
+            datos.assign(tam, T());
+            mascara = tam - 1;
+        }
+        inicio = 0;
+        cuenta = 0;
+    }
+    
+    bool vacia() const { return cuenta == 0; }
+    size_t tamano() const { return cuenta; }
+    
+    void push(const T& v) { datos[(inicio + cuenta++) & mascara] = v; }
+    
+    T pop() {
+        T v = datos[inicio];
+        inicio = (inicio + 1) & mascara;
+        cuenta--;
+        return v;
+    }
+};
+
+// Agregados de mostrarEstadisticas. Cada hilo llena los suyos y al final
+// se suman con sumar().
+struct Estadisticas {
+    size_t total = 0;
+    unordered_map<string, size_t> porGenero;
+    map<int, size_t> porDecada;  // 1920 -> nacidos entre 1920 y 1929
+    size_t sinFecha = 0;
+    
+    void sumar(const Estadisticas& o) {
+        total += o.total;
+        for (const auto& g : o.porGenero) porGenero[g.first] += g.second;
+        for (const auto& d : o.porDecada) porDecada[d.first] += d.second;
+        sinFecha += o.sinFecha;
+    }
 };
 
 // ==================== CLASE PRINCIPAL SIMPLIFICADA ====================
 class ArbolGenealogico {
 private:
-    shared_ptr<Nodo> raiz;
+    // Todos los nodos viven en un vector contiguo y se enlazan por ndice;
+    // las posiciones liberadas se reutilizan en la siguiente insercin
+    vector<Nodo> nodos;
+    vector<Indice> libres;
+    vector<Indice> hijosPlano;  // bloques de hijos de todos los nodos
+    size_t huecosHijos;         // posiciones de hijosPlano en bloques abandonados
+    vector<size_t> porGeneracion;  // miembros por nivel; el ltimo nunca es 0
+    // Binary lifting: saltos[k][n] es el ancestro 2^k generaciones por
+    // encima de n, o NULO. Un vector por nivel, todos del tamao de nodos;
+    // hay tantos niveles como pide la generacin ms profunda que se vio.
+    vector<vector<Indice>> saltos;
+    Indice raiz;
     int siguienteID;
+    ColaCircular<Indice> colaNiveles;  // se reutiliza en cada recorrido por niveles
     
     // ==================== FUNCIONES AUXILIARES ====================
-    int obtenerAltura(shared_ptr<Nodo> n) const {
-        return n ? n->altura : 0;
+    // El miembro nuevo no tiene padre: empieza en el nivel 0
+    Indice crearNodo(Miembro m) {
+        m.nivel = 0;
+        Indice i;
+        if (!libres.empty()) {
+            i = libres.back();
+            libres.pop_back();
+            nodos[i] = Nodo(std::move(m));
+        } else {
+            nodos.push_back(Nodo(std::move(m)));
+            i = (Indice)(nodos.size() - 1);
+        }
+        nodos[i].familia = i;
+        for (vector<Indice>& nivel : saltos) {
+            if (nivel.size() < nodos.size()) nivel.resize(nodos.size(), NULO);
+            nivel[i] = NULO;
+        }
+        sumarGeneracion(0);
+        return i;
+    }
+    
+    // Quita las relaciones familiares del nodo y deja su posicin libre
+    void liberarNodo(Indice i) {
+        Nodo& n = nodos[i];
+        restarGeneracion(n.dato.nivel);
+        if (n.padre != NULO) quitarHijo(n.padre, i);
+        for (Indice h : hijos(i)) {
+            nodos[h].padre = NULO;
+            actualizarAncestros(h);
+        }
+        huecosHijos += n.capacidadHijos;
+        n.primerHijo = n.numHijos = n.capacidadHijos = 0;
+        n.padre = NULO;
+        libres.push_back(i);
+    }
+    
+    // ==================== HIJOS (ADYACENCIA CSR) ====================
+    struct RangoHijos {
+        const Indice* inicio;
+        const Indice* fin;
+        const Indice* begin() const { return inicio; }
+        const Indice* end() const { return fin; }
+        size_t size() const { return fin - inicio; }
+        bool empty() const { return inicio == fin; }
+        Indice operator[](size_t i) const { return inicio[i]; }
+        Indice back() const { return fin[-1]; }
+    };
+    
+    // Vista de los hijos de n; deja de ser vlida si se aaden hijos
+    RangoHijos hijos(Indice n) const {
+        const Indice* inicio = hijosPlano.data() + nodos[n].primerHijo;
+        return {inicio, inicio + nodos[n].numHijos};
+    }
+    
+    // Si el bloque de p est lleno se duplica: crece en su sitio si es el
+    // ltimo de hijosPlano y si no se traslada al final. Cuando los bloques
+    // abandonados pasan de la mitad del vector se compacta.
+    void agregarHijo(Indice p, Indice h) {
+        Nodo& n = nodos[p];
+        if (n.numHijos == n.capacidadHijos) {
+            uint32_t capacidad = max<uint32_t>(4, 2 * n.capacidadHijos);
+            if (n.primerHijo + n.capacidadHijos == hijosPlano.size()) {
+                hijosPlano.resize(n.primerHijo + capacidad);
+            } else {
+                uint32_t nuevo = (uint32_t)hijosPlano.size();
+                hijosPlano.resize(nuevo + capacidad);
+                copy_n(hijosPlano.begin() + n.primerHijo, n.numHijos, hijosPlano.begin() + nuevo);
+                huecosHijos += n.capacidadHijos;
+                n.primerHijo = nuevo;
+            }
+            n.capacidadHijos = capacidad;
+        }
+        hijosPlano[n.primerHijo + n.numHijos++] = h;
+        if (huecosHijos > hijosPlano.size() / 2) compactarHijos();
+    }
+    
+    // Quita h de los hijos de p conservando el orden de los dems
+    void quitarHijo(Indice p, Indice h) {
+        Nodo& n = nodos[p];
+        auto inicio = hijosPlano.begin() + n.primerHijo;
+        auto fin = inicio + n.numHijos;
+        auto pos = find(inicio, fin, h);
+        if (pos == fin) return;
+        copy(pos + 1, fin, pos);
+        n.numHijos--;
+    }
+    
+    // Copia los bloques en uso, con su capacidad, a un vector nuevo
+    void compactarHijos() {
+        vector<Indice> plano;
+        plano.reserve(hijosPlano.size() - huecosHijos);
+        for (Nodo& n : nodos) {
+            uint32_t inicio = (uint32_t)plano.size();
+            plano.insert(plano.end(), hijosPlano.begin() + n.primerHijo,
+                         hijosPlano.begin() + n.primerHijo + n.numHijos);
+            plano.resize(inicio + n.capacidadHijos);
+            n.primerHijo = inicio;
+        }
+        hijosPlano.swap(plano);
+        huecosHijos = 0;
     }
     
-    int obtenerBalance(shared_ptr<Nodo> n) const {
-        return n ? obtenerAltura(n->derecho) - obtenerAltura(n->izquierdo) : 0;
+    void sumarGeneracion(int nivel) {
+        if ((size_t)nivel >= porGeneracion.size()) porGeneracion.resize(nivel + 1, 0);
+        porGeneracion[nivel]++;
     }
     
-    void actualizarAltura(shared_ptr<Nodo> n) {
-        if (n) {
-            n->altura = 1 + max(obtenerAltura(n->izquierdo), obtenerAltura(n->derecho));
+    void restarGeneracion(int nivel) {
+        porGeneracion[nivel]--;
+        while (!porGeneracion.empty() && porGeneracion.back() == 0) porGeneracion.pop_back();
+    }
+    
+    int obtenerAltura(Indice n) const {
+        return n != NULO ? nodos[n].altura : 0;
+    }
+    
+    int obtenerBalance(Indice n) const {
+        return n != NULO ? obtenerAltura(nodos[n].derecho) - obtenerAltura(nodos[n].izquierdo) : 0;
+    }
+    
+    void actualizarAltura(Indice n) {
+        if (n != NULO) {
+            nodos[n].altura = 1 + max(obtenerAltura(nodos[n].izquierdo), obtenerAltura(nodos[n].derecho));
         }
     }
     
     // ==================== ROTACIONES AVL ====================
-    shared_ptr<Nodo> rotarDerecha(shared_ptr<Nodo> y) {
-        if (!y || !y->izquierdo) return y;
+    Indice rotarDerecha(Indice y) {
+        if (y == NULO || nodos[y].izquierdo == NULO) return y;
         
-        auto x = y->izquierdo;
-        auto T2 = x->derecho;
+        Indice x = nodos[y].izquierdo;
+        Indice T2 = nodos[x].derecho;
         
-        x->derecho = y;
-        y->izquierdo = T2;
+        nodos[x].derecho = y;
+        nodos[y].izquierdo = T2;
         
         actualizarAltura(y);
         actualizarAltura(x);
@@ -78,14 +277,14 @@ private:
         return x;
     }
     
-    shared_ptr<Nodo> rotarIzquierda(shared_ptr<Nodo> x) {
-        if (!x || !x->derecho) return x;
+    Indice rotarIzquierda(Indice x) {
+        if (x == NULO || nodos[x].derecho == NULO) return x;
         
-        auto y = x->derecho;
-        auto T2 = y->izquierdo;
+        Indice y = nodos[x].derecho;
+        Indice T2 = nodos[y].izquierdo;
         
-        y->izquierdo = x;
-        x->derecho = T2;
+        nodos[y].izquierdo = x;
+        nodos[x].derecho = T2;
         
         actualizarAltura(x);
         actualizarAltura(y);
@@ -94,31 +293,31 @@ private:
     }
     
     // ==================== BALANCEO ====================
-    shared_ptr<Nodo> balancear(shared_ptr<Nodo> nodo) {
-        if (!nodo) return nodo;
+    Indice balancear(Indice nodo) {
+        if (nodo == NULO) return nodo;
         
         actualizarAltura(nodo);
         int balance = obtenerBalance(nodo);
         
         // Caso izquierda-izquierda
-        if (balance < -1 && obtenerBalance(nodo->izquierdo) <= 0) {
+        if (balance < -1 && obtenerBalance(nodos[nodo].izquierdo) <= 0) {
             return rotarDerecha(nodo);
         }
         
         // Caso derecha-derecha
-        if (balance > 1 && obtenerBalance(nodo->derecho) >= 0) {
+        if (balance > 1 && obtenerBalance(nodos[nodo].derecho) >= 0) {
             return rotarIzquierda(nodo);
         }
         
         // Caso izquierda-derecha
-        if (balance < -1 && obtenerBalance(nodo->izquierdo) > 0) {
-            nodo->izquierdo = rotarIzquierda(nodo->izquierdo);
+        if (balance < -1 && obtenerBalance(nodos[nodo].izquierdo) > 0) {
+            nodos[nodo].izquierdo = rotarIzquierda(nodos[nodo].izquierdo);
             return rotarDerecha(nodo);
         }
         
         // Caso derecha-izquierda
-        if (balance > 1 && obtenerBalance(nodo->derecho) < 0) {
-            nodo->derecho = rotarDerecha(nodo->derecho);
+        if (balance > 1 && obtenerBalance(nodos[nodo].derecho) < 0) {
+            nodos[nodo].derecho = rotarDerecha(nodos[nodo].derecho);
             return rotarIzquierda(nodo);
         }
         
@@ -126,89 +325,319 @@ private:
     }
     
     // ==================== OPERACIONES ABB ====================
-    shared_ptr<Nodo> insertarRecursivo(shared_ptr<Nodo> nodo, Miembro miembro) {
-        if (!nodo) {
-            return make_shared<Nodo>(miembro);
+    // La altura de un AVL con n < 2^31 nodos no pasa de 45
+    static const int ALTURA_MAX = 64;
+    
+    // Pone 'nuevo' en el lugar que ocupaba 'viejo' bajo 'padre' (o en la raz)
+    void reemplazarHijo(Indice padre, Indice viejo, Indice nuevo) {
+        if (padre == NULO) {
+            raiz = nuevo;
+        } else if (nodos[padre].izquierdo == viejo) {
+            nodos[padre].izquierdo = nuevo;
+        } else {
+            nodos[padre].derecho = nuevo;
         }
-        
-        if (miembro.id < nodo->dato.id) {
-            nodo->izquierdo = insertarRecursivo(nodo->izquierdo, miembro);
-        } else if (miembro.id > nodo->dato.id) {
-            nodo->derecho = insertarRecursivo(nodo->derecho, miembro);
+    }
+    
+    // Rebalancea de abajo hacia arriba los nodos del camino [0, k).
+    // Se detiene en cuanto un subrbol conserva su altura anterior.
+    void balancearCamino(const Indice camino[], int k) {
+        while (k > 0) {
+            Indice nodo = camino[--k];
+            int antes = nodos[nodo].altura;
+            Indice nuevo = balancear(nodo);
+            if (nuevo != nodo) {
+                reemplazarHijo(k > 0 ? camino[k - 1] : NULO, nodo, nuevo);
+            }
+            if (nodos[nuevo].altura == antes) break;
         }
-        
-        return balancear(nodo);
     }
     
-    shared_ptr<Nodo> buscarRecursivo(shared_ptr<Nodo> nodo, int id) const {
-        if (!nodo || nodo->dato.id == id) {
-            return nodo;
+    void insertarNodo(const Miembro& miembro) {
+        Indice camino[ALTURA_MAX];
+        int k = 0;
+        
+        Indice actual = raiz;
+        while (actual != NULO) {
+            if (miembro.id == nodos[actual].dato.id) return;
+            camino[k++] = actual;
+            actual = miembro.id < nodos[actual].dato.id ? nodos[actual].izquierdo : nodos[actual].derecho;
         }
         
-        if (id < nodo->dato.id) {
-            return buscarRecursivo(nodo->izquierdo, id);
+        Indice nuevo = crearNodo(miembro);
+        if (k == 0) {
+            raiz = nuevo;
+        } else if (miembro.id < nodos[camino[k - 1]].dato.id) {
+            nodos[camino[k - 1]].izquierdo = nuevo;
         } else {
-            return buscarRecursivo(nodo->derecho, id);
+            nodos[camino[k - 1]].derecho = nuevo;
         }
+        
+        balancearCamino(camino, k);
     }
     
-    shared_ptr<Nodo> encontrarMinimo(shared_ptr<Nodo> nodo) {
-        auto actual = nodo;
-        while (actual && actual->izquierdo) {
-            actual = actual->izquierdo;
+    Indice buscarNodo(int id) const {
+        Indice actual = raiz;
+        while (actual != NULO && nodos[actual].dato.id != id) {
+            actual = id < nodos[actual].dato.id ? nodos[actual].izquierdo : nodos[actual].derecho;
         }
         return actual;
     }
     
-    shared_ptr<Nodo> eliminarRecursivo(shared_ptr<Nodo> nodo, int id) {
-        if (!nodo) return nodo;
+    // Resuelve de una vez los IDs ordenados (con repeticiones) ids[0, cuantos)
+    // del subrbol de 'nodo': cada rama recibe solo los IDs que pueden estar
+    // en ella, as que los caminos comunes se recorren una sola vez. Los no
+    // encontrados conservan el valor que ya tenan en resultado.
+    void resolverOrdenados(Indice nodo, const int* ids, Indice* resultado, size_t cuantos) const {
+        while (nodo != NULO && cuantos > 0) {
+            int id = nodos[nodo].dato.id;
+            size_t m = lower_bound(ids, ids + cuantos, id) - ids;
+            resolverOrdenados(nodos[nodo].izquierdo, ids, resultado, m);
+            while (m < cuantos && ids[m] == id) resultado[m++] = nodo;
+            ids += m;
+            resultado += m;
+            cuantos -= m;
+            nodo = nodos[nodo].derecho;
+        }
+    }
+    
+    void eliminarNodo(int id) {
+        Indice camino[ALTURA_MAX];
+        int k = 0;
         
-        if (id < nodo->dato.id) {
-            nodo->izquierdo = eliminarRecursivo(nodo->izquierdo, id);
-        } else if (id > nodo->dato.id) {
-            nodo->derecho = eliminarRecursivo(nodo->derecho, id);
+        Indice nodo = raiz;
+        while (nodo != NULO && nodos[nodo].dato.id != id) {
+            camino[k++] = nodo;
+            nodo = id < nodos[nodo].dato.id ? nodos[nodo].izquierdo : nodos[nodo].derecho;
+        }
+        if (nodo == NULO) return;
+        
+        Indice padre = k > 0 ? camino[k - 1] : NULO;
+        
+        if (nodos[nodo].izquierdo == NULO || nodos[nodo].derecho == NULO) {
+            Indice hijo = nodos[nodo].izquierdo != NULO ? nodos[nodo].izquierdo : nodos[nodo].derecho;
+            reemplazarHijo(padre, nodo, hijo);
         } else {
-            if (!nodo->izquierdo || !nodo->derecho) {
-                auto temp = nodo->izquierdo ? nodo->izquierdo : nodo->derecho;
-                nodo.reset();
-                return temp;
+            // El sucesor ocupa el lugar del nodo: cada miembro conserva
+            // su posicin y con ella sus relaciones padre/hijos
+            int posNodo = k;
+            camino[k++] = nodo;
+            Indice sucesor = nodos[nodo].derecho;
+            while (nodos[sucesor].izquierdo != NULO) {
+                camino[k++] = sucesor;
+                sucesor = nodos[sucesor].izquierdo;
+            }
+            reemplazarHijo(camino[k - 1], sucesor, nodos[sucesor].derecho);
+            
+            nodos[sucesor].izquierdo = nodos[nodo].izquierdo;
+            nodos[sucesor].derecho = nodos[nodo].derecho;
+            nodos[sucesor].altura = nodos[nodo].altura;
+            reemplazarHijo(padre, nodo, sucesor);
+            camino[posNodo] = sucesor;
+        }
+        
+        liberarNodo(nodo);
+        balancearCamino(camino, k);
+    }
+    
+    // ==================== CARGA MASIVA ====================
+    // Enlaza v[lo, hi) (ordenado por ID) como un subrbol perfectamente
+    // balanceado y devuelve su raz. Cada nodo se visita una sola vez.
+    Indice construirBalanceado(const vector<Indice>& v, size_t lo, size_t hi) {
+        if (lo >= hi) return NULO;
+        size_t medio = lo + (hi - lo) / 2;
+        Indice n = v[medio];
+        nodos[n].izquierdo = construirBalanceado(v, lo, medio);
+        nodos[n].derecho = construirBalanceado(v, medio + 1, hi);
+        actualizarAltura(n);
+        return n;
+    }
+    
+    // ==================== NDICE GENEALGICO ====================
+    // Cada familia (un miembro sin padre y sus descendientes) tiene su propio
+    // espacio de etiquetas de 64 bits. Al colgar un subrbol de s miembros
+    // bajo un padre se etiqueta dentro del hueco libre tras el ltimo hijo,
+    // usando la mitad del hueco para dejar sitio a los siguientes hermanos.
+    // Si el hueco no alcanza se reetiqueta la familia entera repartiendo el
+    // espacio por igual. As enlazar cuesta O(s log n) y no O(n).
+    
+    // x es y o un ancestro de y? (x e y de la misma familia)
+    bool contiene(Indice x, Indice y) const {
+        return nodos[x].entrada <= nodos[y].entrada && nodos[y].salida <= nodos[x].salida;
+    }
+    
+    // Descendientes de r (incluido) en preorden, siguiendo 'hijos'
+    void subarbolGenealogico(Indice r, vector<Indice>& resultado) const {
+        resultado.clear();
+        resultado.push_back(r);
+        for (size_t i = 0; i < resultado.size(); i++) {
+            for (Indice h : hijos(resultado[i])) resultado.push_back(h);
+        }
+    }
+    
+    // Asigna a r y sus descendientes etiquetas lo + paso, lo + 2*paso...
+    // en el orden de entrada y salida del recorrido de Euler
+    void etiquetar(Indice r, uint64_t lo, uint64_t paso) {
+        vector<pair<Indice, size_t>> pila;
+        uint64_t etiqueta = lo;
+        nodos[r].entrada = etiqueta += paso;
+        pila.emplace_back(r, 0);
+        while (!pila.empty()) {
+            Indice n = pila.back().first;
+            size_t& siguiente = pila.back().second;
+            if (siguiente < nodos[n].numHijos) {
+                Indice h = hijosPlano[nodos[n].primerHijo + siguiente++];
+                nodos[h].entrada = etiqueta += paso;
+                pila.emplace_back(h, 0);
             } else {
-                auto temp = encontrarMinimo(nodo->derecho);
-                nodo->dato = temp->dato;
-                nodo->derecho = eliminarRecursivo(nodo->derecho, temp->dato.id);
+                nodos[n].salida = etiqueta += paso;
+                pila.pop_back();
             }
         }
+    }
+    
+    // Recalcula familia, nivel y tabla de saltos de r y sus descendientes
+    // a partir del padre de r. Solo se toca el subrbol que cambi.
+    void actualizarAncestros(Indice r) {
+        vector<Indice> sub;
+        subarbolGenealogico(r, sub);
+        for (vector<Indice>& nivel : saltos) {
+            if (nivel.size() < nodos.size()) nivel.resize(nodos.size(), NULO);
+        }
+        for (Indice n : sub) {
+            Nodo& nodo = nodos[n];
+            int nivel = nodo.padre == NULO ? 0 : nodos[nodo.padre].dato.nivel + 1;
+            if (nivel != nodo.dato.nivel) {
+                restarGeneracion(nodo.dato.nivel);
+                sumarGeneracion(nivel);
+                nodo.dato.nivel = nivel;
+            }
+            nodo.familia = nodo.padre == NULO ? n : nodos[nodo.padre].familia;
+            while (((uint64_t)1 << saltos.size()) <= (uint64_t)nivel) saltos.emplace_back(nodos.size(), NULO);
+            // Los ancestros ya estn al da: sub va de padres a hijos
+            Indice arriba = nodo.padre;
+            for (vector<Indice>& saltosNivel : saltos) {
+                saltosNivel[n] = arriba;
+                if (arriba != NULO) arriba = saltosNivel[arriba];
+            }
+        }
+    }
+    
+    // Cuelga el subrbol de 'hijo' (sin padre) como ltimo hijo de 'padre'
+    void enlazar(Indice padre, Indice hijo) {
+        RangoHijos hermanos = hijos(padre);
+        uint64_t lo = hermanos.empty() ? nodos[padre].entrada : nodos[hermanos.back()].salida;
+        uint64_t hueco = nodos[padre].salida - lo;
+        
+        agregarHijo(padre, hijo);
+        nodos[hijo].padre = padre;
         
-        return balancear(nodo);
+        vector<Indice> sub;
+        subarbolGenealogico(hijo, sub);
+        uint64_t paso = hueco / 2 / (2 * sub.size() + 1);
+        if (paso >= 2) {
+            etiquetar(hijo, lo, paso);
+        } else {
+            Indice f = nodos[padre].familia;
+            subarbolGenealogico(f, sub);
+            etiquetar(f, 0, UINT64_MAX / (2 * sub.size() + 1));
+        }
+        actualizarAncestros(hijo);
+    }
+    
+    Indice ancestroComunIndice(Indice a, Indice b) const {
+        if (nodos[a].familia != nodos[b].familia) return NULO;
+        if (contiene(a, b)) return a;
+        if (contiene(b, a)) return b;
+        // Se sube desde a con saltos decrecientes sin llegar a ancestros de b
+        for (size_t k = saltos.size(); k-- > 0;) {
+            Indice s = saltos[k][a];
+            if (s != NULO && !contiene(s, b)) a = s;
+        }
+        return nodos[a].padre;
     }
     
     // ==================== RECORRIDOS ====================
-    void inordenRecursivo(shared_ptr<Nodo> nodo, vector<shared_ptr<Nodo>>& resultado) const {
-        if (nodo) {
-            inordenRecursivo(nodo->izquierdo, resultado);
+    void inordenRecursivo(Indice nodo, vector<Indice>& resultado) const {
+        if (nodo != NULO) {
+            inordenRecursivo(nodos[nodo].izquierdo, resultado);
             resultado.push_back(nodo);
-            inordenRecursivo(nodo->derecho, resultado);
+            inordenRecursivo(nodos[nodo].derecho, resultado);
         }
     }
     
-    void preordenRecursivo(shared_ptr<Nodo> nodo, vector<shared_ptr<Nodo>>& resultado) const {
-        if (nodo) {
+    void preordenRecursivo(Indice nodo, vector<Indice>& resultado) const {
+        if (nodo != NULO) {
             resultado.push_back(nodo);
-            preordenRecursivo(nodo->izquierdo, resultado);
-            preordenRecursivo(nodo->derecho, resultado);
+            preordenRecursivo(nodos[nodo].izquierdo, resultado);
+            preordenRecursivo(nodos[nodo].derecho, resultado);
         }
     }
     
-    void postordenRecursivo(shared_ptr<Nodo> nodo, vector<shared_ptr<Nodo>>& resultado) const {
-        if (nodo) {
-            postordenRecursivo(nodo->izquierdo, resultado);
-            postordenRecursivo(nodo->derecho, resultado);
+    void postordenRecursivo(Indice nodo, vector<Indice>& resultado) const {
+        if (nodo != NULO) {
+            postordenRecursivo(nodos[nodo].izquierdo, resultado);
+            postordenRecursivo(nodos[nodo].derecho, resultado);
             resultado.push_back(nodo);
         }
     }
+    
+    // ==================== ESTADSTICAS EN PARALELO ====================
+    
+    // Suma un miembro a los agregados; el ao son los 4 primeros dgitos de la fecha
+    static void acumular(const Miembro& m, Estadisticas& e) {
+        e.total++;
+        e.porGenero[m.genero]++;
+        
+        const string& f = m.fechaNacimiento;
+        bool conAnio = f.size() >= 4;
+        int anio = 0;
+        for (size_t i = 0; conAnio && i < 4; i++) {
+            if (f[i] < '0' || f[i] > '9') conAnio = false;
+            else anio = anio * 10 + (f[i] - '0');
+        }
+        if (conAnio) e.porDecada[anio / 10 * 10]++;
+        else e.sinFecha++;
+    }
+    
+    // Recorre un subrbol con una pila explcita
+    void acumularSubarbol(Indice r, Estadisticas& e) const {
+        Indice pila[ALTURA_MAX];
+        int k = 0;
+        pila[k++] = r;
+        while (k > 0) {
+            const Nodo& n = nodos[pila[--k]];
+            acumular(n.dato, e);
+            if (n.derecho != NULO) pila[k++] = n.derecho;
+            if (n.izquierdo != NULO) pila[k++] = n.izquierdo;
+        }
+    }
+    
+    // Recorrido por niveles (BFS); finNivel(nivel) marca el final de cada nivel.
+    // La cola guarda como mucho un nivel y parte del siguiente: con altura h
+    // no pasa de min(n, 3 * 2^(h-2)) + 1 elementos.
+    template <class Visitante, class FinNivel>
+    void recorrerNiveles(Visitante visitar, FinNivel finNivel) {
+        if (raiz == NULO) return;
+        int h = nodos[raiz].altura;
+        size_t ancho = h >= 2 ? (size_t(3) << (h - 2)) : 1;
+        colaNiveles.preparar(min(nodos.size() - libres.size(), ancho) + 1);
+        colaNiveles.push(raiz);
+        
+        for (int nivel = 0; !colaNiveles.vacia(); nivel++) {
+            size_t tamanoNivel = colaNiveles.tamano();
+            while (tamanoNivel--) {
+                Indice i = colaNiveles.pop();
+                visitar(i);
+                if (nodos[i].izquierdo != NULO) colaNiveles.push(nodos[i].izquierdo);
+                if (nodos[i].derecho != NULO) colaNiveles.push(nodos[i].derecho);
+            }
+            finNivel(nivel);
+        }
+    }
 
 public:
-    ArbolGenealogico() : siguienteID(1000) {
+    ArbolGenealogico() : huecosHijos(0), raiz(NULO), siguienteID(1000) {
         srand(time(0));
     }
     
@@ -219,44 +648,248 @@ public:
         
         // Crear miembros de ejemplo
         vector<Miembro> miembros = {
-            {50, "Fundador Principal", "1900-01-01", "M", 0},
-            {30, "Hijo Mayor", "1920-03-20", "M", 1},
-            {70, "Hija Menor", "1925-07-12", "F", 1},
-            {20, "Nieto A", "1940-05-10", "M", 2},
-            {40, "Nieta B", "1942-08-25", "F", 2},
-            {60, "Nieto C", "1945-11-30", "M", 2},
-            {80, "Nieta D", "1948-12-05", "F", 2},
-            {10, "Bisnieto A", "1960-02-14", "M", 3},
-            {25, "Bisnieta B", "1962-06-18", "F", 3},
-            {35, "Bisnieto C", "1965-09-22", "M", 3}
+            {50, "Fundador Principal", "1900-01-01", "M"},
+            {30, "Hijo Mayor", "1920-03-20", "M"},
+            {70, "Hija Menor", "1925-07-12", "F"},
+            {20, "Nieto A", "1940-05-10", "M"},
+            {40, "Nieta B", "1942-08-25", "F"},
+            {60, "Nieto C", "1945-11-30", "M"},
+            {80, "Nieta D", "1948-12-05", "F"},
+            {10, "Bisnieto A", "1960-02-14", "M"},
+            {25, "Bisnieta B", "1962-06-18", "F"},
+            {35, "Bisnieto C", "1965-09-22", "M"}
         };
         
-        for (const auto& miembro : miembros) {
-            raiz = insertarRecursivo(raiz, miembro);
-        }
+        cargarMasivo(std::move(miembros));
         
         // Establecer relaciones familiares
-        establecerRelacion(50, 30);
-        establecerRelacion(50, 70);
-        establecerRelacion(30, 20);
-        establecerRelacion(30, 40);
-        establecerRelacion(70, 60);
-        establecerRelacion(70, 80);
-        establecerRelacion(20, 10);
-        establecerRelacion(20, 25);
-        establecerRelacion(40, 35);
+        establecerRelaciones({
+            {50, 30}, {50, 70}, {30, 20}, {30, 40}, {70, 60},
+            {70, 80}, {20, 10}, {20, 25}, {40, 35}
+        });
         
         cout << "? rbol de ejemplo creado con 10 miembros" << endl;
     }
     
-    void establecerRelacion(int idPadre, int idHijo) {
-        auto padre = buscarRecursivo(raiz, idPadre);
-        auto hijo = buscarRecursivo(raiz, idHijo);
+    // Carga muchos miembros de una vez en O(n) (ms el orden si hace falta).
+    // Los nodos actuales se mezclan con los nuevos y todo se reconstruye
+    // perfectamente balanceado; los nodos existentes conservan su ndice
+    // y sus relaciones. Ante IDs repetidos se queda el miembro que ya
+    // estaba, o el primero de la entrada.
+    void cargarMasivo(vector<Miembro>&& miembros) {
+        auto porId = [](const Miembro& a, const Miembro& b) { return a.id < b.id; };
+        if (!is_sorted(miembros.begin(), miembros.end(), porId)) {
+            stable_sort(miembros.begin(), miembros.end(), porId);
+        }
+        
+        vector<Indice> actuales;
+        inordenRecursivo(raiz, actuales);
+        nodos.reserve(nodos.size() + miembros.size());
+        
+        vector<Indice> todos;
+        todos.reserve(actuales.size() + miembros.size());
+        size_t i = 0;
+        for (size_t j = 0; j < miembros.size(); j++) {
+            int id = miembros[j].id;
+            if (j > 0 && id == miembros[j - 1].id) continue;
+            while (i < actuales.size() && nodos[actuales[i]].dato.id < id) {
+                todos.push_back(actuales[i++]);
+            }
+            if (i < actuales.size() && nodos[actuales[i]].dato.id == id) continue;
+            todos.push_back(crearNodo(std::move(miembros[j])));
+        }
+        while (i < actuales.size()) {
+            todos.push_back(actuales[i++]);
+        }
+        
+        miembros.clear();
+        raiz = construirBalanceado(todos, 0, todos.size());
+    }
+    
+    // Hace de idHijo hijo de idPadre, quitndolo de su padre anterior.
+    // Devuelve false si algn ID no existe o si creara un ciclo.
+    bool establecerRelacion(int idPadre, int idHijo) {
+        Indice padre = buscarNodo(idPadre);
+        Indice hijo = buscarNodo(idHijo);
+        
+        if (padre == NULO || hijo == NULO) return false;
+        if (nodos[padre].familia == nodos[hijo].familia && contiene(hijo, padre)) return false;
+        if (nodos[hijo].padre == padre) return true;
+        
+        if (nodos[hijo].padre != NULO) {
+            quitarHijo(nodos[hijo].padre, hijo);
+            nodos[hijo].padre = NULO;
+        }
+        enlazar(padre, hijo);
+        return true;
+    }
+    
+    // Carga muchas relaciones (idPadre, idHijo) de una vez. El resultado es
+    // el de llamar a establecerRelacion con cada una en orden. Los IDs se
+    // ordenan y se resuelven con una sola bajada por el rbol, los hijos se
+    // reconstruyen en un nico bloque contiguo y cada familia afectada se
+    // reetiqueta una vez.
+    // Devuelve cuntos miembros acabaron con un padre distinto.
+    size_t establecerRelaciones(const vector<pair<int, int>>& relaciones) {
+        // Extremos (id, 2 * relacin + lado) ordenados por ID
+        size_t e = 2 * relaciones.size();
+        vector<pair<int, uint32_t>> extremos(e);
+        for (size_t i = 0; i < relaciones.size(); i++) {
+            extremos[2 * i] = {relaciones[i].first, (uint32_t)(2 * i)};
+            extremos[2 * i + 1] = {relaciones[i].second, (uint32_t)(2 * i + 1)};
+        }
+        sort(extremos.begin(), extremos.end());
+        vector<int> ids(e);
+        for (size_t i = 0; i < e; i++) ids[i] = extremos[i].first;
+        vector<Indice> encontrados(e, NULO);
+        resolverOrdenados(raiz, ids.data(), encontrados.data(), e);
+        vector<Indice> resueltos(e);
+        for (size_t i = 0; i < e; i++) resueltos[extremos[i].second] = encontrados[i];
+        
+        // Se repasan las relaciones en orden sobre los padres, como hara
+        // establecerRelacion: se salta la que no cambia el padre y se rechaza
+        // la que cerrara un ciclo (subiendo desde el nuevo padre, salvo que
+        // el hijo no tenga hijos). Los bloques de hijos y las etiquetas no se
+        // tocan hasta el final.
+        const uint32_t NINGUNA = 0xFFFFFFFFu;
+        vector<pair<Indice, Indice>> aristas;
+        aristas.reserve(relaciones.size());
+        vector<uint32_t> ultima(nodos.size(), NINGUNA);  // ltima arista de cada movido
+        vector<Indice> anterior(nodos.size(), NULO);     // su padre antes del lote
+        vector<uint32_t> numHijos(nodos.size());
+        for (Indice i = 0; i < nodos.size(); i++) numHijos[i] = nodos[i].numHijos;
+        for (size_t i = 0; i < relaciones.size(); i++) {
+            Indice padre = resueltos[2 * i];
+            Indice hijo = resueltos[2 * i + 1];
+            if (padre == NULO || hijo == NULO || padre == hijo || padre == nodos[hijo].padre) continue;
+            if (numHijos[hijo] > 0) {
+                Indice x = padre;
+                while (x != NULO && x != hijo) x = nodos[x].padre;
+                if (x == hijo) continue;
+            }
+            if (ultima[hijo] == NINGUNA) anterior[hijo] = nodos[hijo].padre;
+            if (nodos[hijo].padre != NULO) numHijos[nodos[hijo].padre]--;
+            numHijos[padre]++;
+            ultima[hijo] = (uint32_t)aristas.size();
+            aristas.emplace_back(padre, hijo);
+            nodos[hijo].padre = padre;
+        }
+        
+        // Los movidos, en el orden de su ltima relacin;
+        // como en establecerRelacion, esa relacin lo deja al final de la
+        // lista de su padre final
+        vector<Indice> movidos;
+        size_t aplicadas = 0;
+        for (uint32_t a = 0; a < aristas.size(); a++) {
+            Indice hijo = aristas[a].second;
+            if (ultima[hijo] != a) continue;
+            movidos.push_back(hijo);
+            if (nodos[hijo].padre != anterior[hijo]) aplicadas++;
+        }
+        
+        // Nuevos bloques de hijos: primero los que ya estaban, en su orden,
+        // y despus los movidos en el orden de su ltima relacin
+        vector<uint32_t> inicio(nodos.size() + 1, 0);
+        for (const Nodo& n : nodos) {
+            if (n.padre != NULO) inicio[n.padre + 1]++;
+        }
+        for (size_t i = 0; i < nodos.size(); i++) inicio[i + 1] += inicio[i];
+        vector<Indice> plano(inicio.back());
+        vector<uint32_t> cursor(inicio.begin(), inicio.end() - 1);
+        for (Indice p = 0; p < nodos.size(); p++) {
+            for (Indice h : hijos(p)) {
+                if (nodos[h].padre == p && ultima[h] == NINGUNA) plano[cursor[p]++] = h;
+            }
+        }
+        for (Indice m : movidos) {
+            Indice padre = nodos[m].padre;
+            if (padre != NULO) plano[cursor[padre]++] = m;
+        }
+        for (Indice i = 0; i < nodos.size(); i++) {
+            nodos[i].primerHijo = inicio[i];
+            nodos[i].numHijos = nodos[i].capacidadHijos = inicio[i + 1] - inicio[i];
+        }
+        hijosPlano.swap(plano);
+        huecosHijos = 0;
+        
+        // Se reetiquetan las familias que ahora contienen algn movido
+        vector<uint8_t> estado(nodos.size(), 0);
+        vector<Indice> sub;
+        for (Indice m : movidos) {
+            Indice x = m;
+            while (nodos[x].padre != NULO && !estado[x]) {
+                estado[x] = 1;
+                x = nodos[x].padre;
+            }
+            if (estado[x]) continue;
+            estado[x] = 1;
+            subarbolGenealogico(x, sub);
+            etiquetar(x, 0, UINT64_MAX / (2 * sub.size() + 1));
+            actualizarAncestros(x);
+        }
+        return aplicadas;
+    }
+    
+    // Generacin ms profunda (-1 con el rbol vaco), en O(1)
+    int maxGeneracion() const {
+        return (int)porGeneracion.size() - 1;
+    }
+    
+    size_t miembrosEnGeneracion(int nivel) const {
+        return nivel >= 0 && (size_t)nivel < porGeneracion.size() ? porGeneracion[nivel] : 0;
+    }
+    
+    // idA es ancestro (padre, abuelo...) de idB? O(1) tras buscar los nodos
+    bool esAncestro(int idA, int idB) const {
+        Indice a = buscarNodo(idA);
+        Indice b = buscarNodo(idB);
+        return a != NULO && b != NULO && a != b && nodos[a].familia == nodos[b].familia && contiene(a, b);
+    }
+    
+    // Ancestro comn ms cercano en O(log n); -1 si no lo hay
+    int ancestroComun(int idA, int idB) const {
+        Indice a = buscarNodo(idA);
+        Indice b = buscarNodo(idB);
+        if (a == NULO || b == NULO) return -1;
+        Indice c = ancestroComunIndice(a, b);
+        return c != NULO ? nodos[c].dato.id : -1;
+    }
+    
+    // IDs de todos los descendientes de id, en preorden
+    vector<int> descendientes(int id) const {
+        vector<int> resultado;
+        Indice n = buscarNodo(id);
+        if (n == NULO) return resultado;
+        vector<Indice> sub;
+        subarbolGenealogico(n, sub);
+        resultado.reserve(sub.size() - 1);
+        for (size_t i = 1; i < sub.size(); i++) resultado.push_back(nodos[sub[i]].dato.id);
+        return resultado;
+    }
+    
+    void consultarParentesco() {
+        cout << "\n?? CONSULTAR PARENTESCO" << endl;
+        int idA, idB;
+        cout << "ID del primer miembro: "; cin >> idA;
+        cout << "ID del segundo miembro: "; cin >> idB;
+        
+        if (buscarNodo(idA) == NULO || buscarNodo(idB) == NULO) {
+            cout << "? Miembro no encontrado" << endl;
+            return;
+        }
+        
+        if (esAncestro(idA, idB)) cout << idA << " es ancestro de " << idB << endl;
+        else if (esAncestro(idB, idA)) cout << idB << " es ancestro de " << idA << endl;
+        else cout << "Ninguno es ancestro del otro" << endl;
         
-        if (padre && hijo) {
-            padre->hijos.push_back(hijo);
-            hijo->padre = padre;
+        int comun = ancestroComun(idA, idB);
+        if (comun != -1) {
+            cout << "Ancestro comn ms cercano: " << nodos[buscarNodo(comun)].dato.nombre
+                 << " [" << comun << "]" << endl;
+        } else {
+            cout << "No tienen ancestros en comn" << endl;
         }
+        cout << "Descendientes de " << idA << ": " << descendientes(idA).size() << endl;
     }
     
     void insertarMiembro() {
@@ -270,8 +903,8 @@ public:
         cout << "Fecha de nacimiento (YYYY-MM-DD): "; cin >> fecha;
         cout << "Gnero (M/F): "; cin >> genero;
         
-        Miembro nuevo(id, nombre, fecha, genero, 0);
-        raiz = insertarRecursivo(raiz, nuevo);
+        Miembro nuevo(id, nombre, fecha, genero);
+        insertarNodo(nuevo);
         
         cout << "? Miembro insertado con ID: " << id << endl;
     }
@@ -282,21 +915,23 @@ public:
         int id;
         cin >> id;
         
-        auto resultado = buscarRecursivo(raiz, id);
-        if (resultado) {
+        Indice encontrado = buscarNodo(id);
+        if (encontrado != NULO) {
+            const Nodo& resultado = nodos[encontrado];
             cout << "? MIEMBRO ENCONTRADO:" << endl;
-            resultado->dato.mostrar();
+            resultado.dato.mostrar();
             cout << endl;
             
-            if (resultado->padre) {
-                cout << "Padre: " << resultado->padre->dato.nombre << endl;
+            if (resultado.padre != NULO) {
+                cout << "Padre: " << nodos[resultado.padre].dato.nombre << endl;
             }
             
-            if (!resultado->hijos.empty()) {
+            RangoHijos listaHijos = hijos(encontrado);
+            if (!listaHijos.empty()) {
                 cout << "Hijos: ";
-                for (size_t i = 0; i < resultado->hijos.size(); i++) {
-                    cout << resultado->hijos[i]->dato.nombre;
-                    if (i < resultado->hijos.size() - 1) cout << ", ";
+                for (size_t i = 0; i < listaHijos.size(); i++) {
+                    cout << nodos[listaHijos[i]].dato.nombre;
+                    if (i < listaHijos.size() - 1) cout << ", ";
                 }
                 cout << endl;
             }
@@ -311,8 +946,8 @@ public:
         int id;
         cin >> id;
         
-        if (buscarRecursivo(raiz, id)) {
-            raiz = eliminarRecursivo(raiz, id);
+        if (buscarNodo(id) != NULO) {
+            eliminarNodo(id);
             cout << "? Miembro eliminado correctamente" << endl;
         } else {
             cout << "? Miembro no encontrado" << endl;
@@ -323,7 +958,7 @@ public:
         cout << "\n?? RECORRIDO " << tipo << endl;
         cout << string(50, '-') << endl;
         
-        vector<shared_ptr<Nodo>> resultado;
+        vector<Indice> resultado;
         
         if (tipo == "INORDEN") {
             inordenRecursivo(raiz, resultado);
@@ -335,7 +970,7 @@ public:
         
         for (size_t i = 0; i < resultado.size(); i++) {
             cout << i + 1 << ". ";
-            resultado[i]->dato.mostrar();
+            nodos[resultado[i]].dato.mostrar();
             cout << endl;
         }
     }
@@ -344,38 +979,31 @@ public:
         cout << "\n?? RECORRIDO POR NIVELES" << endl;
         cout << string(50, '-') << endl;
         
-        if (!raiz) {
+        if (raiz == NULO) {
             cout << "El rbol est vaco" << endl;
             return;
         }
         
-        queue<shared_ptr<Nodo>> cola;
-        cola.push(raiz);
+        bool inicioNivel = true;
         int nivel = 0;
-        
-        while (!cola.empty()) {
-            int tamanoNivel = cola.size();
-            cout << "Nivel " << nivel << ": ";
-            
-            for (int i = 0; i < tamanoNivel; i++) {
-                auto nodo = cola.front();
-                cola.pop();
-                
-                cout << nodo->dato.nombre << "(" << nodo->dato.id << ") ";
-                
-                if (nodo->izquierdo) cola.push(nodo->izquierdo);
-                if (nodo->derecho) cola.push(nodo->derecho);
-            }
-            cout << endl;
-            nivel++;
-        }
+        recorrerNiveles(
+            [&](Indice i) {
+                if (inicioNivel) cout << "Nivel " << nivel << ": ";
+                inicioNivel = false;
+                cout << nodos[i].dato.nombre << "(" << nodos[i].dato.id << ") ";
+            },
+            [&](int) {
+                cout << endl;
+                inicioNivel = true;
+                nivel++;
+            });
     }
     
     void mostrarEstructura() {
         cout << "\n?? ESTRUCTURA DEL RBOL" << endl;
         cout << string(60, '=') << endl;
         
-        if (!raiz) {
+        if (raiz == NULO) {
             cout << "El rbol est vaco" << endl;
             return;
         }
@@ -383,54 +1011,184 @@ public:
         mostrarArbolRecursivo(raiz, 0);
     }
     
-    void mostrarArbolRecursivo(shared_ptr<Nodo> nodo, int espacio) {
-        if (!nodo) return;
+    void mostrarArbolRecursivo(Indice nodo, int espacio) {
+        if (nodo == NULO) return;
         
         espacio += 4;
         
-        mostrarArbolRecursivo(nodo->derecho, espacio);
+        mostrarArbolRecursivo(nodos[nodo].derecho, espacio);
         
         cout << endl;
         for (int i = 4; i < espacio; i++) {
             cout << " ";
         }
-        cout << nodo->dato.nombre << " [" << nodo->dato.id << "]" << endl;
+        cout << nodos[nodo].dato.nombre << " [" << nodos[nodo].dato.id << "]" << endl;
+        
+        mostrarArbolRecursivo(nodos[nodo].izquierdo, espacio);
+    }
+    
+    // Fork-join: se baja por niveles hasta tener unos 8 subrboles por
+    // hilo (los nodos de arriba se cuentan aqu mismo), los hilos se
+    // reparten los subrboles tomando el siguiente libre de un contador
+    // atmico y al final se suman los agregados parciales.
+    // hilos = 0 usa todos los ncleos.
+    Estadisticas calcularEstadisticas(unsigned hilos = 0) const {
+        if (hilos == 0) hilos = max(1u, thread::hardware_concurrency());
+        Estadisticas total;
+        if (raiz == NULO) return total;
+        
+        vector<Indice> tareas = {raiz};
+        while (hilos > 1 && !tareas.empty() && tareas.size() < 8 * hilos) {
+            vector<Indice> siguientes;
+            for (Indice t : tareas) {
+                acumular(nodos[t].dato, total);
+                if (nodos[t].izquierdo != NULO) siguientes.push_back(nodos[t].izquierdo);
+                if (nodos[t].derecho != NULO) siguientes.push_back(nodos[t].derecho);
+            }
+            tareas.swap(siguientes);
+        }
+        
+        vector<Estadisticas> parciales(hilos);
+        atomic<size_t> siguiente(0);
+        auto trabajar = [&](unsigned h) {
+            size_t i;
+            while ((i = siguiente.fetch_add(1)) < tareas.size()) {
+                acumularSubarbol(tareas[i], parciales[h]);
+            }
+        };
         
-        mostrarArbolRecursivo(nodo->izquierdo, espacio);
+        vector<thread> trabajadores;
+        for (unsigned h = 1; h < hilos; h++) trabajadores.emplace_back(trabajar, h);
+        trabajar(0);
+        for (thread& t : trabajadores) t.join();
+        
+        for (const Estadisticas& p : parciales) total.sumar(p);
+        return total;
     }
     
     void mostrarEstadisticas() {
         cout << "\n?? ESTADSTICAS DEL RBOL" << endl;
         cout << string(40, '-') << endl;
         
-        if (!raiz) {
+        if (raiz == NULO) {
             cout << "El rbol est vaco" << endl;
             return;
         }
         
-        int total = 0;
-        int maxNivel = 0;
-        int hombres = 0, mujeres = 0;
+        Estadisticas e = calcularEstadisticas();
         
-        vector<shared_ptr<Nodo>> todos;
-        inordenRecursivo(raiz, todos);
+        cout << "Total de miembros: " << e.total << endl;
+        cout << "Altura del rbol: " << obtenerAltura(raiz) << endl;
+        cout << "Mximo nivel genealgico: " << maxGeneracion() << endl;
+        cout << "Hombres: " << e.porGenero["M"] << endl;
+        cout << "Mujeres: " << e.porGenero["F"] << endl;
+        cout << "Balance del rbol: " << obtenerBalance(raiz) << endl;
         
-        for (size_t i = 0; i < todos.size(); i++) {
-            total++;
-            maxNivel = max(maxNivel, todos[i]->dato.nivel);
-            if (todos[i]->dato.genero == "M") hombres++;
-            else if (todos[i]->dato.genero == "F") mujeres++;
+        cout << "Miembros por generacin:" << endl;
+        for (int g = 0; g <= maxGeneracion(); g++) {
+            cout << "  Nivel " << g << ": " << miembrosEnGeneracion(g) << endl;
         }
         
-        cout << "Total de miembros: " << total << endl;
-        cout << "Altura del rbol: " << obtenerAltura(raiz) << endl;
-        cout << "Mximo nivel genealgico: " << maxNivel << endl;
-        cout << "Hombres: " << hombres << endl;
-        cout << "Mujeres: " << mujeres << endl;
-        cout << "Balance del rbol: " << obtenerBalance(raiz) << endl;
+        cout << "Nacimientos por dcada:" << endl;
+        for (const auto& d : e.porDecada) {
+            cout << "  " << d.first << "s: " << d.second << endl;
+        }
+        if (e.sinFecha > 0) cout << "  Sin fecha vlida: " << e.sinFecha << endl;
     }
 };
 
+// ==================== PRUEBA DE ESCALABILIDAD ====================
+// Genera un rbol de n miembros y mide calcularEstadisticas con 1, 2, 4...
+// hilos hasta el nmero de ncleos
+void pruebaEscalabilidad() {
+    cout << "\n?? ESCALABILIDAD DE LAS ESTADSTICAS" << endl;
+    cout << "Nmero de miembros (0 = 10000000): ";
+    int n;
+    cin >> n;
+    if (n <= 0) n = 10000000;
+    
+    ArbolGenealogico arbol;
+    {
+        vector<Miembro> miembros;
+        miembros.reserve(n);
+        const char* generos[] = {"M", "F"};
+        for (int i = 0; i < n; i++) {
+            string fecha = to_string(1500 + i % 500) + "-01-01";
+            miembros.emplace_back(i, "Miembro", fecha, generos[i % 2]);
+        }
+        arbol.cargarMasivo(std::move(miembros));
+    }
+    
+    unsigned nucleos = max(1u, thread::hardware_concurrency());
+    vector<unsigned> configuraciones;
+    for (unsigned h = 1; h < nucleos; h *= 2) configuraciones.push_back(h);
+    configuraciones.push_back(nucleos);
+    
+    cout << n << " miembros, " << nucleos << " ncleos" << endl;
+    double base = 0;
+    for (unsigned hilos : configuraciones) {
+        auto inicio = chrono::steady_clock::now();
+        Estadisticas e = arbol.calcularEstadisticas(hilos);
+        double seg = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        if (hilos == 1) base = seg;
+        
+        cout << setw(4) << hilos << (hilos == 1 ? " hilo:  " : " hilos: ")
+             << fixed << setprecision(3) << seg << " s  aceleracin "
+             << setprecision(2) << base / seg << "x" << endl;
+        if (e.total != (size_t)n) cout << "  (recuento incorrecto)" << endl;
+    }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
+
+// ==================== PRUEBA DE CARGA DE RELACIONES ====================
+// Genera n miembros y una genealoga aleatoria (el padre de i es uno
+// anterior) y compara establecerRelacion arista a arista con
+// establecerRelaciones en lote
+void pruebaCargaRelaciones() {
+    cout << "\n?? CARGA DE RELACIONES" << endl;
+    cout << "Nmero de miembros (0 = 1000000): ";
+    int n;
+    cin >> n;
+    if (n <= 0) n = 1000000;
+    
+    vector<pair<int, int>> relaciones;
+    relaciones.reserve(n);
+    srand(7);
+    for (int i = 1; i < n; i++) {
+        relaciones.emplace_back((int)(((uint64_t)rand() * RAND_MAX + rand()) % i), i);
+    }
+    
+    double segundos[2];
+    size_t aplicadas[2] = {0, 0};
+    for (int lote = 0; lote < 2; lote++) {
+        ArbolGenealogico arbol;
+        vector<Miembro> miembros;
+        miembros.reserve(n);
+        for (int i = 0; i < n; i++) miembros.emplace_back(i, "Miembro", "1900-01-01", "M");
+        arbol.cargarMasivo(std::move(miembros));
+        
+        auto inicio = chrono::steady_clock::now();
+        if (lote) {
+            aplicadas[lote] = arbol.establecerRelaciones(relaciones);
+        } else {
+            for (const auto& r : relaciones) aplicadas[lote] += arbol.establecerRelacion(r.first, r.second);
+        }
+        segundos[lote] = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    }
+    
+    cout << relaciones.size() << " relaciones" << endl;
+    cout << fixed << setprecision(3);
+    cout << "  una a una:  " << segundos[0] << " s" << endl;
+    cout << "  en lote:    " << segundos[1] << " s  (" << setprecision(2)
+         << segundos[0] / segundos[1] << "x)" << endl;
+    if (aplicadas[0] != relaciones.size() || aplicadas[1] != relaciones.size()) {
+        cout << "  (recuento incorrecto)" << endl;
+    }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
+
 // ==================== MEN PRINCIPAL ====================
 void mostrarMenu() {
     cout << "\n" << string(50, '=') << endl;
@@ -446,6 +1204,9 @@ void mostrarMenu() {
     cout << "8. Mostrar por niveles" << endl;
     cout << "9. Mostrar estructura del rbol" << endl;
     cout << "10. Mostrar estadsticas" << endl;
+    cout << "11. Prueba de escalabilidad de las estadsticas" << endl;
+    cout << "12. Consultar parentesco entre dos miembros" << endl;
+    cout << "13. Prueba de carga de relaciones en lote" << endl;
     cout << "0. Salir" << endl;
     cout << string(50, '-') << endl;
     cout << "Seleccione una opcin: ";
@@ -492,6 +1253,15 @@ int main() {
             case 10:
                 arbol.mostrarEstadisticas();
                 break;
+            case 11:
+                pruebaEscalabilidad();
+                break;
+            case 12:
+                arbol.consultarParentesco();
+                break;
+            case 13:
+                pruebaCargaRelaciones();
+                break;
             case 0:
                 cout << "?? Hasta pronto!" << endl;
                 break;